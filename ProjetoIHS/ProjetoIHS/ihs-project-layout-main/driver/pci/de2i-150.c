@@ -7,6 +7,11 @@
 #include <linux/cdev.h>      // Suporte para drivers de caractere
 #include <linux/uaccess.h>   // Acesso a espaço do usuário
 #include <linux/pci.h>       // Manipulação de dispositivos PCI
+#include <linux/slab.h>      // Alocação de memória no kernel (kcalloc/kfree)
+#include <linux/input.h>     // Subsistema de entrada (evdev)
+#include <linux/build_bug.h> // Verificações em tempo de compilação (BUILD_BUG_ON)
+
+#include "../../include/ioctl_cmds.h" // Comandos IOCTL compartilhados com o espaço do usuário
 
 // Definição de metadados do módulo
 /*
@@ -16,12 +21,20 @@ MODULE_LICENSE("GPL"); // Declara a licença sobre o qual o modulo do kernel é
 MODULE_AUTHOR("mfbsouza");// Declara o autor do módulo
 MODULE_DESCRIPTION("Simple PCI driver for DE2i-150 dev board");// Declara a descrição do módulo, descreve o propósito do módulo
 
+// Parâmetro do módulo (insmod de2i-150.ko switch_events=1)
+// As chaves só viram eventos EV_SW quando pedido: o sistema dá significado aos códigos SW_* e o SDL não entrega EV_SW ao jogo
+static bool switch_events = false;
+module_param(switch_events, bool, 0444);
+MODULE_PARM_DESC(switch_events, "Report the board switches as EV_SW events (default: off)");
+
 // Definições de constantes
 #define DRIVER_NAME      "my_driver"   	// Nome do driver // Finalidade de identificar o driver no kernel
 #define FILE_NAME        "mydev"       	// Nome do arquivo do dispositivo // Arquivo criado no sistema de arquivos(/dev) e permite que os app de espaço do usuário interajam com o driver
 #define DRIVER_CLASS     "MyModuleClass"// Classe do dispositivo // Defini-se classe para agrupar dispositivos relacionados no sistema de arquivos
 #define MY_PCI_VENDOR_ID  0x1172        // ID do fornecedor PCI
 #define MY_PCI_DEVICE_ID  0x0004        // ID do dispositivo PCI
+#define INPUT_NAME       "DE2i-150 board buttons" // Nome do dispositivo de entrada (aparece em /proc/bus/input/devices)
+#define INPUT_POLL_MS    10             // Intervalo de leitura dos botões e chaves para o dispositivo de entrada
 
 // Prototipação das funções
 /*
@@ -87,31 +100,220 @@ static void __iomem* bar0_mmio = NULL; // Base do mapeamento do BAR0 (Base Addre
 static void __iomem* read_pointer = NULL; // Ponteiro de leitura configurado para acessar uma região específica do dispositivo PCI // É inicializado com base no mapeamento de bar0_mmio e um deslocamento (offset) para o registrador ou área de leitura // Permite que o driver leia dados do dispositivo PCI 
 static void __iomem* write_pointer = NULL; // Ponteiro de escrita configurado para acessar uma região específica do dispositivo PCI // É inicializado com base no mapeamento de bar0_mmio e um deslocamento (offset) para o registrador ou área de escrita // Permite que o driver escreva dados no dispositivo PCI // Está configurado dinamicamente a função my_ioctl com base no comando recebido do usuário.
 
-// Definição de nomes dos periféricos para fins de depuração no dmesg
-static const char* peripheral[] = {
-    "switches",     // Interruptores
-    "p_buttons",    // Botões físicos
-    "display_l",    // Display esquerdo
-    "display_r",    // Display direito
-    "green_leds",   // LEDs verdes
-    "red_leds"      // LEDs vermelhos
+// Tabela de registradores gerada a partir do mapa em include/regmap.h
+/*
+	- Indexada pelo número do comando IOCTL (_IOC_NR(cmd) - REGMAP_FIRST_NR), então o my_ioctl não precisa de switch.
+	- Novos periféricos ou mudanças de offset são feitos apenas no regmap.h.
+*/
+struct reg_desc {
+    unsigned int offset; // Deslocamento do registrador dentro do BAR0
+    unsigned int width;  // Número de bits válidos
+    int dir;             // REG_RD ou REG_WR
+    const char* label;   // Nome do periférico para fins de depuração no dmesg
+};
+
+static const struct reg_desc regs[REG_COUNT] = {
+#define REGMAP_DESC(cmd, id, nr, off, bits, rw, name) [REG_##cmd] = { off, bits, rw, name },
+    REGMAP(REGMAP_DESC)
+#undef REGMAP_DESC
 };
 
-// Enumeração de índices para identificar os periféricos conectados ao disp. PCI
-enum perf_names_idx {
-    IDX_SWITCH = 0,  // Índice dos interruptores
-    IDX_PBUTTONS,    // Índice dos botões físicos
-    IDX_DISPLAYL,    // Índice do display esquerdo
-    IDX_DISPLAYR,    // Índice do display direito
-    IDX_GREENLED,    // Índice dos LEDs verdes
-    IDX_REDLED       // Índice dos LEDs vermelhos
+// Variáveis para controlar os periféricos (índices de regs) usados na escrita e leitura
+static int wr_name_idx = REG_WR_L_DISPLAY; // Índice do periférico de escrita padrão (display esquerdo)
+static int rd_name_idx = REG_RD_PBUTTONS;  // Índice do periférico de leitura padrão (botões físicos)
+
+// Modo de escrita de cada display (DISPLAY_MODE_* | DISPLAY_NO_ZEROS), indexado por wr_name_idx
+// Permite que o usuário escreva um inteiro ou texto e o driver faça a codificação para os segmentos
+// Fica em filp->private_data: cada arquivo aberto tem seus próprios modos e começa em DISPLAY_MODE_RAW,
+// assim um processo não herda o modo deixado por outro (ex.: o jogo sai em decimal e o app envia segmentos)
+struct file_state {
+    unsigned int display_mode[REG_COUNT];
+};
+
+// Dispositivo de entrada (evdev) com os botões e as chaves da placa
+/*
+	- Os botões são reportados como teclas (EV_KEY) e, com switch_events=1, as chaves como EV_SW, assim aplicações (ex.: pygame/SDL)
+	  recebem eventos pela pilha de entrada do sistema sem fazer ioctl + read a cada quadro.
+	- Os registradores são lidos a cada INPUT_POLL_MS e só as mudanças geram eventos.
+	- As chaves nunca usam SW_LID, SW_TABLET_MODE, SW_RFKILL_ALL ou SW_DOCK: com eles o systemd-logind
+	  suspende ou desencaixa a máquina e o rfkill-input desliga os rádios.
+*/
+static struct input_dev* board_input = NULL;
+static unsigned int last_buttons; // Último valor lido dos botões (ativos em nível baixo)
+static unsigned int last_switches; // Último valor lido das chaves
+
+// Tecla reportada por cada botão (PB0 a PB3), mesma disposição usada pelo jogo
+static const unsigned short button_keys[] = { KEY_RIGHT, KEY_DOWN, KEY_UP, KEY_LEFT };
+
+// Código EV_SW de cada chave (SW0, SW1, ...) com switch_events ligado; as chaves que sobram não são reportadas
+static const unsigned short switch_codes[] = {
+    SW_HEADPHONE_INSERT, SW_MICROPHONE_INSERT, SW_LINEOUT_INSERT, SW_JACK_PHYSICAL_INSERT,
+    SW_VIDEOOUT_INSERT, SW_CAMERA_LENS_COVER, SW_KEYPAD_SLIDE, SW_FRONT_PROXIMITY,
+    SW_ROTATE_LOCK, SW_LINEIN_INSERT, SW_MUTE_DEVICE, SW_PEN_INSERTED
+};
+
+// Fonte ASCII (0x20 a 0x7F) para o display de 7 segmentos
+/*
+	- Cada byte segue a ordem dos segmentos do display: bit0 = a, bit1 = b, ..., bit6 = g, bit7 = ponto
+	- A fonte é armazenada em lógica positiva (1 = segmento aceso); o display da placa é ativo em nível baixo,
+	  então o valor é invertido em seg7_encode().
+*/
+static const unsigned char seg7_font[96] = {
+    0x00, 0x86, 0x22, 0x7E, 0x6D, 0xD2, 0x46, 0x20, //   ! " # $ % & '
+    0x29, 0x0B, 0x21, 0x70, 0x10, 0x40, 0x80, 0x52, // ( ) * + , - . /
+    0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, // 0 1 2 3 4 5 6 7
+    0x7F, 0x6F, 0x09, 0x0D, 0x61, 0x48, 0x43, 0xD3, // 8 9 : ; < = > ?
+    0x5F, 0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71, 0x3D, // @ A B C D E F G
+    0x76, 0x30, 0x1E, 0x75, 0x38, 0x15, 0x37, 0x3F, // H I J K L M N O
+    0x73, 0x6B, 0x33, 0x6D, 0x78, 0x3E, 0x3E, 0x2A, // P Q R S T U V W
+    0x76, 0x6E, 0x5B, 0x39, 0x64, 0x0F, 0x23, 0x08, // X Y Z [ \ ] ^ _
+    0x02, 0x5F, 0x7C, 0x58, 0x5E, 0x7B, 0x71, 0x6F, // ` a b c d e f g
+    0x74, 0x10, 0x0C, 0x75, 0x30, 0x14, 0x54, 0x5C, // h i j k l m n o
+    0x73, 0x67, 0x50, 0x6D, 0x78, 0x1C, 0x1C, 0x14, // p q r s t u v w
+    0x76, 0x6E, 0x5B, 0x46, 0x30, 0x70, 0x01, 0x00  // x y z { | } ~
 };
 
-// Variáveis para controlar os nomes de periféricos usados na escrita e leitura
-static int wr_name_idx = IDX_DISPLAYR; // Índice do periférico de escrita padrão (display direito)
-static int rd_name_idx = IDX_SWITCH;   // Índice do periférico de leitura padrão (interruptores)
+// Dígitos usados nos modos decimal e hexadecimal
+static const char seg7_digits[] = "0123456789ABCDEF";
 
 
+// Converte um caractere ASCII para o byte do display (ativo em nível baixo)
+static unsigned char seg7_encode(unsigned char c)
+{
+    // Caracteres fora da fonte ficam apagados
+    if (c < 0x20 || c >= 0x80)
+        return 0xFF;
+    return (unsigned char)~seg7_font[c - 0x20];
+}
+
+// Codifica o valor escrito pelo usuário de acordo com o modo do display
+static unsigned int display_render(unsigned int data, size_t len, unsigned int mode)
+{
+    /*
+		- unsigned int data = Dados copiados do espaço do usuário.
+		- size_t len = Número de bytes válidos em data (usado no modo texto).
+		- unsigned int mode = Modo do display (DISPLAY_MODE_* | DISPLAY_NO_ZEROS).
+		- O dígito mais à esquerda do display fica no byte mais significativo do retorno.
+	*/
+    unsigned int out = 0;
+    unsigned int base;
+    unsigned char seg;
+    int i;
+
+    switch (mode & DISPLAY_MODE_MASK) {
+        case DISPLAY_MODE_DEC:
+            base = 10;
+            break;
+        case DISPLAY_MODE_HEX:
+            base = 16;
+            break;
+        case DISPLAY_MODE_TEXT:
+            // Os caracteres chegam na ordem do buffer do usuário; posições que sobram ficam apagadas
+            for (i = 0; i < 4; i++)
+                out = (out << 8) | seg7_encode((size_t)i < len ? ((const unsigned char*)&data)[i] : ' ');
+            return out;
+        default:
+            return data;
+    }
+
+    // Números maiores que 4 dígitos mostram apenas os 4 dígitos menos significativos
+    for (i = 0; i < 4; i++) {
+        if (i > 0 && data == 0 && (mode & DISPLAY_NO_ZEROS))
+            seg = 0xFF; // Zero à esquerda apagado
+        else
+            seg = seg7_encode(seg7_digits[data % base]);
+        data /= base;
+        out |= (unsigned int)seg << (8 * i);
+    }
+    return out;
+}
+
+// Máscara com os bits válidos de um registrador
+static unsigned int reg_mask(int idx)
+{
+    return regs[idx].width >= 32 ? 0xFFFFFFFF : (1U << regs[idx].width) - 1;
+}
+
+// Número de chaves reportadas como EV_SW (nenhuma sem switch_events)
+static unsigned int input_switch_count(void)
+{
+    if (!switch_events)
+        return 0;
+    return min_t(unsigned int, regs[REG_RD_SWITCHES].width, ARRAY_SIZE(switch_codes));
+}
+
+// Chamada pelo subsistema de entrada a cada INPUT_POLL_MS
+static void board_input_poll(struct input_dev* input)
+{
+    /*
+		- Lê os registradores direto do BAR0, sem mexer no read_pointer usado pelo dispositivo de caractere.
+		- Compara com a leitura anterior e reporta apenas os bits que mudaram.
+	*/
+    unsigned int buttons = ioread32(bar0_mmio + regs[REG_RD_PBUTTONS].offset) & reg_mask(REG_RD_PBUTTONS);
+    unsigned int switches = 0;
+    unsigned int changed;
+    unsigned int i;
+
+    if (input_switch_count() > 0)
+        switches = ioread32(bar0_mmio + regs[REG_RD_SWITCHES].offset) & reg_mask(REG_RD_SWITCHES);
+
+    if (buttons == last_buttons && switches == last_switches)
+        return;
+
+    changed = buttons ^ last_buttons;
+    for (i = 0; i < ARRAY_SIZE(button_keys); i++)
+        if (changed & (1U << i))
+            input_report_key(input, button_keys[i], !(buttons & (1U << i))); // Botão pressionado = bit em 0
+
+    changed = switches ^ last_switches;
+    for (i = 0; i < input_switch_count(); i++)
+        if (changed & (1U << i))
+            input_report_switch(input, switch_codes[i], !!(switches & (1U << i)));
+
+    input_sync(input);
+    last_buttons = buttons;
+    last_switches = switches;
+}
+
+// Registra o dispositivo de entrada dos botões e chaves
+static int board_input_register(struct pci_dev* dev)
+{
+    unsigned int i;
+    int err;
+
+    if ((board_input = input_allocate_device()) == NULL)
+        return -ENOMEM;
+
+    board_input->name = INPUT_NAME;
+    board_input->phys = DRIVER_NAME "/input0";
+    board_input->id.bustype = BUS_PCI;
+    board_input->id.vendor = MY_PCI_VENDOR_ID;
+    board_input->id.product = MY_PCI_DEVICE_ID;
+    board_input->dev.parent = &dev->dev;
+
+    for (i = 0; i < ARRAY_SIZE(button_keys); i++)
+        input_set_capability(board_input, EV_KEY, button_keys[i]);
+    for (i = 0; i < input_switch_count(); i++)
+        input_set_capability(board_input, EV_SW, switch_codes[i]);
+
+    // Estado inicial: botões soltos e chaves desligadas, a primeira leitura reporta o que estiver diferente
+    last_buttons = reg_mask(REG_RD_PBUTTONS);
+    last_switches = 0;
+
+    if ((err = input_setup_polling(board_input, board_input_poll)) != 0)
+        goto InputError;
+    input_set_poll_interval(board_input, INPUT_POLL_MS);
+
+    if ((err = input_register_device(board_input)) != 0)
+        goto InputError;
+    return 0;
+
+InputError:
+    input_free_device(board_input);
+    board_input = NULL;
+    return err;
+}
+
 // Função de inicialização do driver
 // Chamada automaticamente pelo kernel quando o módulo é carregado
 static int __init my_init(void) // Principal função é configurar e registrar os componentes necessários para que o driver funcione corretamente
@@ -122,6 +324,13 @@ static int __init my_init(void) // Principal função é configurar e registrar
 		Cria o arquivo de dispositivo no sistema de arquivos.
 		Trata erros de forma robusta, garantindo que recursos sejam liberados em caso de falha.
 	*/
+    // Os comandos da tabela de registradores não podem coincidir com os demais comandos IOCTL
+#define REGMAP_CHECK(cmd, id, nr, off, bits, rw, name) \
+    BUILD_BUG_ON((nr) < REGMAP_FIRST_NR || (nr) >= REGMAP_CTRL_NR); \
+    BUILD_BUG_ON((unsigned int)(cmd) == (unsigned int)WR_DISPLAY_MODE);
+    REGMAP(REGMAP_CHECK)
+#undef REGMAP_CHECK
+
     printk("my_driver: loaded to the kernel\n");
     
     // Registra o driver PCI
@@ -195,6 +404,11 @@ static void __exit my_exit(void)
 */
 static int my_open(struct inode* inode, struct file* filp)
 {
+    // Estado próprio deste arquivo aberto, zerado = DISPLAY_MODE_RAW em todos os displays
+    filp->private_data = kzalloc(sizeof(struct file_state), GFP_KERNEL);
+    if (filp->private_data == NULL)
+        return -ENOMEM;
+
     printk("my_driver: open was called\n"); // Mensagem de depuração informando que o dispositivo foi aberto
     return 0; // Retorna 0 indicando sucesso
 }
@@ -203,6 +417,7 @@ static int my_open(struct inode* inode, struct file* filp)
 static int my_close(struct inode* inode, struct file* filp)
 {
 	// Essa função é chamada quando um processo tenta fechar o dispositivo
+    kfree(filp->private_data); // Libera o estado alocado em my_open
     printk("my_driver: close was called\n"); // Mensagem de depuração informando que o dispositivo foi fechado
     return 0; // Retorna 0 indicando sucesso
 }
@@ -228,7 +443,7 @@ static ssize_t my_read(struct file* filp, char __user* buf, size_t count, loff_t
 
     // Lê um valor de 32 bits do dispositivo no endereço apontado por read_pointer
     temp_read = ioread32(read_pointer);
-    printk("my_driver: read 0x%X from the %s\n", temp_read, peripheral[rd_name_idx]); // Exibe o valor lido e o periferico correspondente
+    printk("my_driver: read 0x%X from the %s\n", temp_read, regs[rd_name_idx].label); // Exibe o valor lido e o periferico correspondente
 
     // Determina a quantidade de bytes a copiar para o usuário
     to_cpy = (count <= sizeof(temp_read)) ? count : sizeof(temp_read);
@@ -254,6 +469,7 @@ static ssize_t my_write(struct file* filp, const char __user* buf, size_t count,
 	// O ponteiro de escrita é configurado com base no comando IOCTL recebido anteriormente.
 	// O ponteiro de escrita é usado para determinar onde os dados devem ser escritos no dispositivo PCI.
 
+    struct file_state* state = filp->private_data; // Modos de display deste arquivo aberto
     ssize_t retval = 0;
     int to_cpy = 0;
     static unsigned int temp_write = 0; // Armazena temporariamente os dados copiados do espaço do usuário.
@@ -270,11 +486,16 @@ static ssize_t my_write(struct file* filp, const char __user* buf, size_t count,
     // Copia os dados do espaço do usuário
 	// retval armazena o número de bytes que foram copiados com sucesso
 	// copy_from_user retorna o número de bytes que não puderam ser copiados
+    temp_write = 0;
     retval = to_cpy - copy_from_user(&temp_write, buf, to_cpy);
 
+    // Nos displays, converte o valor de acordo com o modo configurado via WR_DISPLAY_MODE
+    if (wr_name_idx == REG_WR_L_DISPLAY || wr_name_idx == REG_WR_R_DISPLAY)
+        temp_write = display_render(temp_write, retval, state->display_mode[wr_name_idx]);
+
     // Escreve os dados no dispositivo
     iowrite32(temp_write, write_pointer); // Usa a função iowrite32 para escrever os dados no endereço apontado por write_pointer
-    printk("my_writer: wrote 0x%X to the %s\n", temp_write, peripheral[wr_name_idx]);
+    printk("my_writer: wrote 0x%X to the %s\n", temp_write, regs[wr_name_idx].label);
 
     return retval;
 }
@@ -287,41 +508,37 @@ static long int my_ioctl(struct file* filp, unsigned int cmd, unsigned long arg)
 		- unsigned int cmd = Comando IOCTL recebido do usuário.
 		- unsigned long arg = Argumento adicional passado pelo usuário (geralmente um ponteiro para dados ou uma estrutura).
 	*/
-    switch(cmd) {
-        case RD_SWITCHES:
-            // Configura o ponteiro de leitura para os interruptores
-            read_pointer = bar0_mmio + 0xC0A0; // TODO: atualizar offset
-            rd_name_idx = IDX_SWITCH;
-            break;
-        case RD_PBUTTONS:
-            // Configura o ponteiro de leitura para os botões físicos
-            read_pointer = bar0_mmio + 0xC080; // TODO: atualizar offset
-            rd_name_idx = IDX_PBUTTONS;
-            break;
-        case WR_L_DISPLAY:
-            // Configura o ponteiro de escrita para o display esquerdo
-            write_pointer = bar0_mmio + 0xC000; // TODO: atualizar offset
-            wr_name_idx = IDX_DISPLAYL;
-            break;
-        case WR_R_DISPLAY:
-            // Configura o ponteiro de escrita para o display direito
-            write_pointer = bar0_mmio + 0xC060; // TODO: atualizar offset
-            wr_name_idx = IDX_DISPLAYR;
-            break;
-        case WR_RED_LEDS:
-            // Configura o ponteiro de escrita para os LEDs vermelhos
-            write_pointer = bar0_mmio + 0xC0C0; // TODO: atualizar offset
-            wr_name_idx = IDX_REDLED;
-            break;
-        case WR_GREEN_LEDS:
-            // Configura o ponteiro de escrita para os LEDs verdes
-            write_pointer = bar0_mmio + 0xC0E0; // TODO: atualizar offset
-            wr_name_idx = IDX_GREENLED;
-            break;
-        default:
-            // Comando IOCTL desconhecido
-            printk("my_driver: unknown ioctl command: 0x%X\n", cmd);
+    struct file_state* state = filp->private_data; // Modos de display deste arquivo aberto
+    unsigned int idx = _IOC_NR(cmd) - REGMAP_FIRST_NR; // Índice do registrador na tabela
+
+    // Comandos do mapa de registradores: seleciona o ponteiro de leitura ou escrita
+    if (cmd == _IO(REGMAP_IOC_MAGIC, _IOC_NR(cmd)) && idx < REG_COUNT) {
+        if (regs[idx].dir == REG_RD) {
+            read_pointer = bar0_mmio + regs[idx].offset;
+            rd_name_idx = idx;
+        } else {
+            write_pointer = bar0_mmio + regs[idx].offset;
+            wr_name_idx = idx;
+        }
+        return 0;
+    }
+
+    if (cmd == WR_DISPLAY_MODE) {
+        // Configura o modo de escrita do display selecionado (arg = DISPLAY_MODE_* | DISPLAY_NO_ZEROS)
+        if (wr_name_idx != REG_WR_L_DISPLAY && wr_name_idx != REG_WR_R_DISPLAY) {
+            printk("my_driver: display mode set while %s is selected\n", regs[wr_name_idx].label);
+            return -EINVAL;
+        }
+        if ((arg & DISPLAY_MODE_MASK) > DISPLAY_MODE_TEXT) {
+            printk("my_driver: unknown display mode: 0x%lX\n", arg);
+            return -EINVAL;
+        }
+        state->display_mode[wr_name_idx] = arg;
+        return 0;
     }
+
+    // Comando IOCTL desconhecido
+    printk("my_driver: unknown ioctl command: 0x%X\n", cmd);
     return 0;
 }
 
@@ -370,8 +587,12 @@ static int __init my_pci_probe(struct pci_dev *dev, const struct pci_device_id *
 
     // Inicializa ponteiros de leitura e escrita padrão
 	// É necessário para que o driver possa acessar diretamente os registradores ou áreas de memória do dispositivo PCI.
-    write_pointer = bar0_mmio + 0xC000; // TODO: atualizar offset
-    read_pointer  = bar0_mmio + 0xC080; // TODO: atualizar offset
+    write_pointer = bar0_mmio + regs[wr_name_idx].offset;
+    read_pointer  = bar0_mmio + regs[rd_name_idx].offset;
+
+    // Registra o dispositivo de entrada; sem ele o dispositivo de caractere continua funcionando
+    if (board_input_register(dev) != 0)
+        printk("my_driver: input device could not be registered!\n");
 
     return 0;
 }
@@ -380,6 +601,12 @@ static int __init my_pci_probe(struct pci_dev *dev, const struct pci_device_id *
 static void __exit my_pci_remove(struct pci_dev *dev)
 {
 	// Aqui serve para liberar os recursos alocados durante a inicialização do dispositivo PCI e desabilitar o dispositivo.
+    // Para a leitura periódica antes de desmapear o BAR0
+    if (board_input != NULL) {
+        input_unregister_device(board_input);
+        board_input = NULL;
+    }
+
     read_pointer = NULL;
     write_pointer = NULL;
 
@@ -0,0 +1,54 @@
+#ifndef __ASSET_BUNDLE_H__
+#define __ASSET_BUNDLE_H__
+
+#include <stdint.h>	/* uints types */
+
+/*
+ * Layout of the asset bundle written by tools/asset_packer.cpp and memory
+ * mapped by the game (PyPacman/src/assets.py). Everything is little endian.
+ *
+ *   asset_bundle_header
+ *   asset_bundle_entry[entry_count]
+ *   atlas pixels, RGBA 8 bits per channel, aligned to ASSET_PAGE_ALIGN
+ *   sound PCM data, each one aligned to ASSET_DATA_ALIGN
+ */
+
+#define ASSET_BUNDLE_MAGIC   "IHSPAK\0"
+#define ASSET_BUNDLE_VERSION 1
+#define ASSET_NAME_LEN       64
+#define ASSET_PAGE_ALIGN     4096
+#define ASSET_DATA_ALIGN     64
+
+enum asset_kind {
+	ASSET_IMAGE = 1,	/* rect inside the atlas */
+	ASSET_SOUND = 2		/* raw PCM in the bundle audio format */
+};
+
+struct asset_bundle_header {
+	char     magic[8];		/* ASSET_BUNDLE_MAGIC */
+	uint32_t version;		/* ASSET_BUNDLE_VERSION */
+	uint32_t entry_count;
+	uint32_t atlas_width;
+	uint32_t atlas_height;
+	uint64_t atlas_offset;		/* atlas_width * 4 bytes per row */
+	uint32_t audio_freq;		/* sample rate of every sound */
+	uint16_t audio_format;		/* SDL audio format, AUDIO_S16LSB */
+	uint16_t audio_channels;
+	uint32_t reserved[2];
+};
+
+struct asset_bundle_entry {
+	char     name[ASSET_NAME_LEN];	/* path relative to the game folder */
+	uint32_t kind;			/* enum asset_kind */
+	uint32_t x, y, w, h;		/* ASSET_IMAGE only */
+	uint32_t reserved;
+	uint64_t offset;		/* ASSET_SOUND only */
+	uint64_t size;
+};
+
+#ifdef __cplusplus
+static_assert(sizeof(asset_bundle_header) == 48, "asset_bundle_header layout changed");
+static_assert(sizeof(asset_bundle_entry) == 104, "asset_bundle_entry layout changed");
+#endif
+
+#endif /* __ASSET_BUNDLE_H__ */
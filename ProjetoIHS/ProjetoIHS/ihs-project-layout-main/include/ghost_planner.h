@@ -0,0 +1,101 @@
+#ifndef __GHOST_PLANNER_H__
+#define __GHOST_PLANNER_H__
+
+#include <stdint.h>	/* uints types */
+
+/* moves in the order get_direction() tries them (PyPacman ghost_movement_utils.py) */
+enum ghost_dir {
+	GHOST_UP = 0,
+	GHOST_LEFT,
+	GHOST_DOWN,
+	GHOST_RIGHT,
+	GHOST_DIR_COUNT
+};
+
+#define GHOST_NO_DIR   -1	/* every move is blocked */
+#define GHOST_FALLBACK -2	/* the python version would index out of the matrix, let it decide */
+
+/* one decision: tile the ghost is on, tile it is heading to and the
+ * move it can not take (the reverse of its current one), -1 for none */
+struct ghost_query {
+	int32_t row;
+	int32_t col;
+	int32_t target_row;
+	int32_t target_col;
+	int32_t prev;
+};
+
+#ifdef __cplusplus
+
+#include <atomic>		/* std::atomic */
+#include <condition_variable>	/* std::condition_variable */
+#include <mutex>		/* std::mutex */
+#include <thread>		/* std::thread */
+#include <unordered_map>	/* std::unordered_map */
+#include <vector>		/* std::vector */
+
+/* batch version of the greedy ghost movement: the decision only depends
+ * on (tile, target, prev) and the walls, so it is cached on that key and
+ * the cache is dropped when the walls change. The misses of a batch are
+ * solved on a small thread pool when there are at least
+ * PLANNER_PARALLEL_MIN (16) of them; the pool is only started by the first
+ * such batch, so with the four ghosts of the stock game it never runs */
+class ghost_planner {
+public:
+	/* workers = 0 picks one per core, up to 3 besides the caller (started on demand) */
+	explicit ghost_planner(unsigned int workers);
+	~ghost_planner();
+
+	/* blocked[row * cols + col] != 0 for the cells ghosts can not enter */
+	void set_matrix(int rows, int cols, const uint8_t* blocked);
+	/* out[i] = ghost_dir, GHOST_NO_DIR or GHOST_FALLBACK, returns the number of misses */
+	int plan(const ghost_query* queries, int count, int8_t* out);
+
+private:
+	struct key_hash {
+		size_t operator()(const ghost_query& q) const;
+	};
+	struct key_equal {
+		bool operator()(const ghost_query& a, const ghost_query& b) const;
+	};
+
+	int8_t solve(const ghost_query& q) const;
+	void solve_misses();
+	bool start_workers();
+	void worker(unsigned int seen);
+
+	int m_rows = 0;
+	int m_cols = 0;
+	std::vector<uint8_t> m_blocked;
+	std::unordered_map<ghost_query, int8_t, key_hash, key_equal> m_cache;
+
+	/* misses of the current batch, only touched by plan() outside a dispatch */
+	std::vector<ghost_query> m_misses;
+	std::vector<int8_t> m_solved;
+
+	/* thread pool */
+	unsigned int m_max_workers;
+	std::vector<std::thread> m_workers;
+	std::mutex m_lock;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	std::atomic<int> m_next{0};
+	unsigned int m_generation = 0;
+	unsigned int m_busy = 0;
+	bool m_quit = false;
+};
+
+extern "C" {
+#endif /* __cplusplus */
+
+/* C interface used by the python game through ctypes */
+void* ihs_planner_open(unsigned int workers);
+void  ihs_planner_close(void* handle);
+void  ihs_planner_set_matrix(void* handle, int rows, int cols, const uint8_t* blocked);
+int   ihs_planner_plan(void* handle, const struct ghost_query* queries, int count, int8_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GHOST_PLANNER_H__ */
@@ -0,0 +1,90 @@
+#ifndef __IO_WORKER_H__
+#define __IO_WORKER_H__
+
+#include <stdint.h>	/* uints types */
+
+/* board outputs that can be posted to the worker */
+enum io_target {
+	IO_DISPLAY_R = 0,
+	IO_DISPLAY_L,
+	IO_RED_LEDS,
+	IO_GREEN_LEDS,
+	IO_TARGET_COUNT
+};
+
+/* the buttons are active low, all four released */
+#define IO_BUTTONS_IDLE 0xF
+
+#ifdef __cplusplus
+
+#include <atomic>	/* std::atomic */
+#include <thread>	/* std::thread */
+
+#include "spsc_queue.h"
+
+/* snapshot of the board inputs taken by the worker */
+struct io_input {
+	uint32_t switches;
+	uint32_t buttons;	/* always IO_BUTTONS_IDLE, the buttons come from evdev */
+};
+
+/* write request, mode is only used by the displays (DISPLAY_MODE_*) */
+struct io_output {
+	uint32_t target;
+	uint32_t mode;
+	uint32_t value;
+};
+
+/* owns the device file on its own thread: polls the inputs at a fixed
+ * period and flushes the posted outputs, so the caller (the game loop)
+ * only ever does non-blocking queue operations */
+class io_worker {
+public:
+	io_worker(int fd, unsigned int period_us);
+	~io_worker();
+
+	/* takes the first input sample synchronously and starts the thread */
+	bool start();
+	void stop();
+
+	/* latest input snapshot, never blocks */
+	bool poll(io_input& input);
+	/* queues an output write, never blocks, false if the queue is full */
+	bool post(const io_output& output);
+
+	int fd() const { return m_fd; }
+
+private:
+	void run();
+	bool read_inputs(io_input& input);
+	void flush_outputs();
+
+	int m_fd;
+	unsigned int m_period_us;
+	std::thread m_thread;
+	std::atomic<bool> m_running{false};
+
+	spsc_latest<io_input> m_inputs;
+	spsc_queue<io_output, 64> m_outputs;
+
+	/* worker thread state used to coalesce the writes */
+	io_output m_pending[IO_TARGET_COUNT];
+	io_output m_written[IO_TARGET_COUNT];
+	bool m_dirty[IO_TARGET_COUNT];
+	bool m_valid[IO_TARGET_COUNT];
+};
+
+extern "C" {
+#endif /* __cplusplus */
+
+/* C interface used by the python game through ctypes */
+void* ihs_io_open(const char* path, unsigned int period_us);
+void  ihs_io_close(void* handle);
+int   ihs_io_poll(void* handle, uint32_t* switches, uint32_t* buttons);
+int   ihs_io_post(void* handle, uint32_t target, uint32_t mode, uint32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __IO_WORKER_H__ */
@@ -1,11 +1,26 @@
 #ifndef __IOCTL_CMDS_H__
 #define __IOCTL_CMDS_H__
 
-#define RD_SWITCHES   _IO('a', 'a')
-#define RD_PBUTTONS   _IO('a', 'b')
-#define WR_L_DISPLAY  _IO('a', 'c')
-#define WR_R_DISPLAY  _IO('a', 'd')
-#define WR_RED_LEDS   _IO('a', 'e')
-#define WR_GREEN_LEDS _IO('a', 'f')
+#include "regmap.h"
+
+/* one command per register of the map: RD_SWITCHES, RD_PBUTTONS,
+ * WR_L_DISPLAY, WR_R_DISPLAY, WR_RED_LEDS and WR_GREEN_LEDS */
+enum ioctl_cmds {
+#define REGMAP_CMD(cmd, id, nr, offset, width, dir, label) cmd = _IO(REGMAP_IOC_MAGIC, nr),
+	REGMAP(REGMAP_CMD)
+#undef REGMAP_CMD
+};
+
+/* selects how the next writes to the current display are rendered,
+ * the ioctl argument is one of the DISPLAY_MODE_* values below,
+ * optionally or'ed with DISPLAY_NO_ZEROS */
+#define WR_DISPLAY_MODE _IO(REGMAP_IOC_MAGIC, REGMAP_CTRL_NR)
+
+#define DISPLAY_MODE_RAW  0x0 /* 32-bit word with the 4 segment bytes (default) */
+#define DISPLAY_MODE_DEC  0x1 /* 32-bit unsigned integer shown in decimal */
+#define DISPLAY_MODE_HEX  0x2 /* 32-bit unsigned integer shown in hexadecimal */
+#define DISPLAY_MODE_TEXT 0x3 /* up to 4 ASCII characters, left aligned */
+#define DISPLAY_MODE_MASK 0xF
+#define DISPLAY_NO_ZEROS  0x10 /* blank leading zeros (DEC and HEX only) */
 
 #endif /* __IOCTL_CMDS_H__ */
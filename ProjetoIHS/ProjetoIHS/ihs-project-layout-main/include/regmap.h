@@ -0,0 +1,50 @@
+#ifndef __REGMAP_H__
+#define __REGMAP_H__
+
+/*
+ * DE2i-150 peripheral register map, the single place where the BAR0
+ * offsets and the ioctl commands of the PCI driver are declared.
+ *
+ * X(cmd, id, nr, offset, width, dir, label)
+ *   cmd    ioctl command name, _IO(REGMAP_IOC_MAGIC, nr)
+ *   id     identifier used by the C++ descriptors (regmap.hpp)
+ *   nr     ioctl number, consecutive from REGMAP_FIRST_NR (it is the table index),
+ *          must stay below REGMAP_CTRL_NR
+ *   offset register offset inside BAR0
+ *   width  number of valid bits
+ *   dir    REG_RD (read by the driver) or REG_WR (written by the driver)
+ *   label  name shown in the kernel log
+ *
+ * Consumers:
+ *   - ioctl_cmds.h turns it into the ioctl commands
+ *   - driver/pci/de2i-150.c builds the ioctl dispatch table from it
+ *   - regmap.hpp gives typed constexpr descriptors to C++
+ *   - tools/gen_regmap.cpp writes the python constants (PyPacman/regmap.py)
+ */
+
+#define REGMAP_IOC_MAGIC 'a'
+#define REGMAP_FIRST_NR  'a'
+/* first ioctl number of the commands that are not registers (WR_DISPLAY_MODE...),
+ * kept apart so new REGMAP lines never reach it */
+#define REGMAP_CTRL_NR   0x80
+
+#define REG_RD 0
+#define REG_WR 1
+
+#define REGMAP(X) \
+	X(RD_SWITCHES,   switches,   'a', 0xC0A0, 18, REG_RD, "switches")   \
+	X(RD_PBUTTONS,   pbuttons,   'b', 0xC080,  4, REG_RD, "p_buttons")  \
+	X(WR_L_DISPLAY,  l_display,  'c', 0xC000, 32, REG_WR, "display_l")  \
+	X(WR_R_DISPLAY,  r_display,  'd', 0xC060, 32, REG_WR, "display_r")  \
+	X(WR_RED_LEDS,   red_leds,   'e', 0xC0C0, 18, REG_WR, "red_leds")   \
+	X(WR_GREEN_LEDS, green_leds, 'f', 0xC0E0,  9, REG_WR, "green_leds")
+
+/* register index, nr - REGMAP_FIRST_NR */
+enum regmap_idx {
+#define REGMAP_IDX(cmd, id, nr, offset, width, dir, label) REG_##cmd = (nr) - REGMAP_FIRST_NR,
+	REGMAP(REGMAP_IDX)
+#undef REGMAP_IDX
+	REG_COUNT
+};
+
+#endif /* __REGMAP_H__ */
@@ -0,0 +1,107 @@
+#ifndef __REGMAP_HPP__
+#define __REGMAP_HPP__
+
+#include <stdint.h>	/* uints types */
+#include <unistd.h>	/* read() write() */
+#include <sys/ioctl.h>	/* ioctl() */
+
+// ioctl commands defined for the pci driver header
+#include "ioctl_cmds.h"
+
+/* typed, compile-time checked view of regmap.h for C++ code */
+namespace regmap {
+
+enum class dir { rd = REG_RD, wr = REG_WR };
+
+struct reg {
+	unsigned long cmd;	/* ioctl that selects the register */
+	uint32_t offset;	/* BAR0 offset, only used by the driver */
+	unsigned int width;	/* valid bits */
+	dir direction;
+	const char* label;
+
+	constexpr uint32_t mask() const
+	{
+		return width >= 32 ? 0xFFFFFFFFu : ((1u << width) - 1);
+	}
+};
+
+/* one descriptor per register: regmap::switches, regmap::pbuttons... */
+#define REGMAP_REG(cmd, id, nr, off, bits, rw, label) \
+	inline constexpr reg id{ cmd, off, bits, static_cast<regmap::dir>(rw), label };
+REGMAP(REGMAP_REG)
+#undef REGMAP_REG
+
+/* same descriptors indexed by regmap_idx */
+inline constexpr reg all[REG_COUNT] = {
+#define REGMAP_REG(cmd, id, nr, off, bits, rw, label) id,
+	REGMAP(REGMAP_REG)
+#undef REGMAP_REG
+};
+
+#define REGMAP_CHECK(cmd, id, nr, off, bits, rw, label) \
+	static_assert((bits) >= 1 && (bits) <= 32, #id ": width must be 1 to 32 bits"); \
+	static_assert((off) % 4 == 0, #id ": offset must be 32-bit aligned"); \
+	static_assert((rw) == REG_RD || (rw) == REG_WR, #id ": unknown direction"); \
+	static_assert(all[REG_##cmd].offset == (off), #id ": ioctl numbers must be consecutive"); \
+	static_assert((nr) >= REGMAP_FIRST_NR && (nr) < REGMAP_CTRL_NR, #id ": ioctl number out of the register range"); \
+	static_assert((unsigned long)(cmd) != (unsigned long)WR_DISPLAY_MODE, #id ": ioctl command taken by WR_DISPLAY_MODE");
+REGMAP(REGMAP_CHECK)
+#undef REGMAP_CHECK
+
+constexpr bool offsets_unique()
+{
+	for (int i = 0; i < REG_COUNT; i++)
+		for (int j = i + 1; j < REG_COUNT; j++)
+			if (all[i].offset == all[j].offset)
+				return false;
+	return true;
+}
+static_assert(offsets_unique(), "two registers share the same offset");
+
+/* bit field of a register, checked against its width */
+template <const reg& R, unsigned int LSB, unsigned int WIDTH = 1>
+struct field {
+	static_assert(WIDTH >= 1, "empty field");
+	static_assert(LSB + WIDTH <= R.width, "field does not fit in the register");
+
+	static constexpr uint32_t mask = (WIDTH >= 32 ? 0xFFFFFFFFu : ((1u << WIDTH) - 1)) << LSB;
+
+	static constexpr uint32_t get(uint32_t value)
+	{
+		return (value & mask) >> LSB;
+	}
+
+	static constexpr uint32_t set(uint32_t value, uint32_t field_value)
+	{
+		return (value & ~mask) | ((field_value << LSB) & mask);
+	}
+};
+
+/* push button N (active low) and switch N */
+template <unsigned int N> using button = field<pbuttons, N>;
+template <unsigned int N> using sw = field<switches, N>;
+/* digit N of a display, 0 is the rightmost */
+template <const reg& R, unsigned int N> using digit = field<R, 8 * N, 8>;
+
+/* register access through the driver, the direction is checked at compile time */
+template <const reg& R>
+inline bool read(int fd, uint32_t& value)
+{
+	static_assert(R.direction == dir::rd, "register is not readable");
+	if (ioctl(fd, R.cmd) < 0 || ::read(fd, &value, sizeof(value)) != sizeof(value))
+		return false;
+	value &= R.mask();
+	return true;
+}
+
+template <const reg& R>
+inline bool write(int fd, uint32_t value)
+{
+	static_assert(R.direction == dir::wr, "register is not writable");
+	return ioctl(fd, R.cmd) >= 0 && ::write(fd, &value, sizeof(value)) == sizeof(value);
+}
+
+} /* namespace regmap */
+
+#endif /* __REGMAP_HPP__ */
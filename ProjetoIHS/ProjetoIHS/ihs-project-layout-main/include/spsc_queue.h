@@ -0,0 +1,82 @@
+#ifndef __SPSC_QUEUE_H__
+#define __SPSC_QUEUE_H__
+
+#include <stddef.h>	/* size_t */
+#include <stdint.h>	/* uints types */
+#include <atomic>	/* std::atomic */
+
+/* lock-free queues for exactly one producer thread and one consumer thread,
+ * none of the operations block or allocate */
+
+#define SPSC_CACHE_LINE 64
+
+/* bounded FIFO ring, N must be a power of two */
+template <typename T, size_t N>
+class spsc_queue {
+	static_assert(N >= 2 && (N & (N - 1)) == 0, "spsc_queue size must be a power of two");
+
+public:
+	/* producer side, returns false when the queue is full */
+	bool push(const T& item)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_head.load(std::memory_order_acquire) == N)
+			return false;
+		m_items[tail & (N - 1)] = item;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* consumer side, returns false when the queue is empty */
+	bool pop(T& item)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+			return false;
+		item = m_items[head & (N - 1)];
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	alignas(SPSC_CACHE_LINE) std::atomic<size_t> m_head{0};
+	alignas(SPSC_CACHE_LINE) std::atomic<size_t> m_tail{0};
+	alignas(SPSC_CACHE_LINE) T m_items[N];
+};
+
+/* single value mailbox where the latest value wins (triple buffer),
+ * the producer never waits for the consumer and older values are dropped */
+template <typename T>
+class spsc_latest {
+public:
+	/* producer side */
+	void store(const T& value)
+	{
+		m_slots[m_back] = value;
+		m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX;
+	}
+
+	/* consumer side, returns false if nothing new was stored since the
+	 * last call, value always holds the most recent value seen */
+	bool load(T& value)
+	{
+		bool fresh = false;
+		if (m_middle.load(std::memory_order_relaxed) & FRESH) {
+			m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+			fresh = true;
+		}
+		value = m_slots[m_front];
+		return fresh;
+	}
+
+private:
+	static constexpr uint8_t INDEX = 0x3;
+	static constexpr uint8_t FRESH = 0x4;
+
+	T m_slots[3] = {};
+	alignas(SPSC_CACHE_LINE) uint8_t m_front = 0;
+	alignas(SPSC_CACHE_LINE) std::atomic<uint8_t> m_middle{1};
+	alignas(SPSC_CACHE_LINE) uint8_t m_back = 2;
+};
+
+#endif /* __SPSC_QUEUE_H__ */
@@ -0,0 +1,241 @@
+#include <stdint.h>	/* uints types */
+#include <string.h>	/* memcmp */
+#include <algorithm>	/* std::min std::max */
+#include <new>		/* std::bad_alloc */
+#include <system_error>	/* std::system_error */
+
+#include "ghost_planner.h"
+
+/* below this many misses waking the pool costs more than solving inline */
+#define PLANNER_PARALLEL_MIN 16
+/* the targets follow pacman, so the cache is bounded and simply dropped when full */
+#define PLANNER_CACHE_MAX    (1 << 16)
+#define PLANNER_MAX_WORKERS  3
+
+/* tile offset of each move */
+static const int move_row[GHOST_DIR_COUNT] = { -1, 0, 1, 0 };
+static const int move_col[GHOST_DIR_COUNT] = { 0, -1, 0, 1 };
+
+/* cells in front of the 2x2 ghost that must be free (DIRECTION_MAPPER) */
+static const int probe[GHOST_DIR_COUNT][2][2] = {
+	{ { -1, 0 }, { -1, 1 } },
+	{ { 0, -1 }, { 1, -1 } },
+	{ { 2, 0 }, { 2, 1 } },
+	{ { 0, 2 }, { 1, 2 } }
+};
+
+size_t ghost_planner::key_hash::operator()(const ghost_query& q) const
+{
+	size_t h = (uint32_t)q.row;
+	h = h * 31 + (uint32_t)q.col;
+	h = h * 31 + (uint32_t)q.target_row;
+	h = h * 31 + (uint32_t)q.target_col;
+	return h * 31 + (uint32_t)q.prev;
+}
+
+bool ghost_planner::key_equal::operator()(const ghost_query& a, const ghost_query& b) const
+{
+	return a.row == b.row && a.col == b.col && a.target_row == b.target_row &&
+	       a.target_col == b.target_col && a.prev == b.prev;
+}
+
+ghost_planner::ghost_planner(unsigned int workers)
+{
+	if (workers == 0) {
+		// hardware_concurrency() is allowed to return 0
+		unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+		workers = std::min(cores, PLANNER_MAX_WORKERS + 1u) - 1;
+	}
+	m_max_workers = std::min(workers, (unsigned int)PLANNER_MAX_WORKERS);
+}
+
+ghost_planner::~ghost_planner()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+	for (auto& thread : m_workers)
+		thread.join();
+}
+
+void ghost_planner::set_matrix(int rows, int cols, const uint8_t* blocked)
+{
+	size_t size = (size_t)rows * cols;
+
+	// the game hands the same level over again on every reset, keep the cache then
+	if (rows == m_rows && cols == m_cols && memcmp(blocked, m_blocked.data(), size) == 0)
+		return;
+
+	// copy first, a failed allocation leaves the old matrix whole
+	std::vector<uint8_t> fresh(blocked, blocked + size);
+	m_blocked.swap(fresh);
+	m_rows = rows;
+	m_cols = cols;
+	m_cache.clear();
+}
+
+/* same rules and tie-breaking as get_direction() */
+int8_t ghost_planner::solve(const ghost_query& q) const
+{
+	int64_t best = INT64_MAX;
+	int8_t best_dir = GHOST_NO_DIR;
+
+	if (m_blocked.empty())
+		return GHOST_FALLBACK;
+
+	for (int dir = 0; dir < GHOST_DIR_COUNT; dir++) {
+		bool valid = true;
+
+		for (int i = 0; i < 2 && valid; i++) {
+			int row = q.row + probe[dir][i][0];
+			int col = q.col + probe[dir][i][1];
+
+			if (col < 0 || col >= m_cols)
+				continue; // the tunnel, python skips these cells too
+			if (row < 0)
+				row += m_rows; // negative index wraps in python
+			if (row < 0 || row >= m_rows)
+				return GHOST_FALLBACK;
+			valid = !m_blocked[(size_t)row * m_cols + col];
+		}
+		if (!valid)
+			continue;
+
+		int next_row = q.row + move_row[dir];
+		int next_col = q.col + move_col[dir];
+		if (next_row < 0 || next_row >= m_rows || dir == q.prev)
+			continue;
+
+		// squared distance keeps the order of the euclidean one
+		int64_t dr = (int64_t)next_row - q.target_row;
+		int64_t dc = (int64_t)next_col - q.target_col;
+		int64_t dist = dr * dr + dc * dc;
+		if (dist < best) {
+			best = dist;
+			best_dir = dir;
+		}
+	}
+	return best_dir;
+}
+
+void ghost_planner::solve_misses()
+{
+	int count = (int)m_misses.size();
+
+	for (int i; (i = m_next.fetch_add(1, std::memory_order_relaxed)) < count;)
+		m_solved[i] = solve(m_misses[i]);
+}
+
+/* false when no worker could be started, the batch is then solved inline */
+bool ghost_planner::start_workers()
+{
+	try {
+		while (m_workers.size() < m_max_workers)
+			m_workers.emplace_back(&ghost_planner::worker, this, m_generation);
+	} catch (const std::system_error&) {
+		m_max_workers = m_workers.size(); // keep the ones already running
+	}
+	return !m_workers.empty();
+}
+
+/* seen is the generation when the worker is started, so a late worker
+ * does not take an old batch for a new one */
+void ghost_planner::worker(unsigned int seen)
+{
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			m_wake.wait(lock, [&] { return m_quit || m_generation != seen; });
+			if (m_quit)
+				return;
+			seen = m_generation;
+		}
+
+		solve_misses();
+
+		std::lock_guard<std::mutex> lock(m_lock);
+		if (--m_busy == 0)
+			m_done.notify_one();
+	}
+}
+
+int ghost_planner::plan(const ghost_query* queries, int count, int8_t* out)
+{
+	std::vector<int> slots;
+
+	m_misses.clear();
+	for (int i = 0; i < count; i++) {
+		auto it = m_cache.find(queries[i]);
+		if (it != m_cache.end()) {
+			out[i] = it->second;
+		} else {
+			m_misses.push_back(queries[i]);
+			slots.push_back(i);
+		}
+	}
+	if (m_misses.empty())
+		return 0;
+
+	m_solved.assign(m_misses.size(), GHOST_FALLBACK);
+	m_next.store(0, std::memory_order_relaxed);
+
+	if (m_max_workers == 0 || m_misses.size() < PLANNER_PARALLEL_MIN || !start_workers()) {
+		solve_misses();
+	} else {
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			m_busy = m_workers.size();
+			m_generation++;
+		}
+		m_wake.notify_all();
+		solve_misses(); // the caller takes its share too
+
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_done.wait(lock, [&] { return m_busy == 0; });
+	}
+
+	if (m_cache.size() + m_misses.size() > PLANNER_CACHE_MAX)
+		m_cache.clear();
+	for (size_t i = 0; i < m_misses.size(); i++) {
+		out[slots[i]] = m_solved[i];
+		m_cache.emplace(m_misses[i], m_solved[i]);
+	}
+	return (int)m_misses.size();
+}
+
+void* ihs_planner_open(unsigned int workers)
+{
+	try {
+		return new ghost_planner(workers);
+	} catch (...) {
+		return NULL;
+	}
+}
+
+void ihs_planner_close(void* handle)
+{
+	delete static_cast<ghost_planner*>(handle);
+}
+
+void ihs_planner_set_matrix(void* handle, int rows, int cols, const uint8_t* blocked)
+{
+	try {
+		static_cast<ghost_planner*>(handle)->set_matrix(rows, cols, blocked);
+	} catch (const std::bad_alloc&) {
+		// the old matrix and its cache stay, plan() still answers for them
+	}
+}
+
+int ihs_planner_plan(void* handle, const struct ghost_query* queries, int count, int8_t* out)
+{
+	try {
+		return static_cast<ghost_planner*>(handle)->plan(queries, count, out);
+	} catch (const std::bad_alloc&) {
+		// let the python version decide the whole batch
+		for (int i = 0; i < count; i++)
+			out[i] = GHOST_FALLBACK;
+		return -1;
+	}
+}
@@ -0,0 +1,193 @@
+#include <stdio.h>	/* fprintf */
+#include <string.h>	/* memset */
+#include <stdint.h>	/* uints types */
+#include <unistd.h>	/* close() read() write() */
+#include <fcntl.h>	/* open() */
+#include <sys/ioctl.h>	/* ioctl() */
+#include <chrono>	/* steady_clock */
+#include <new>		/* std::nothrow */
+#include <system_error>	/* std::system_error */
+
+// register map and ioctl commands defined for the pci driver
+#include "regmap.hpp"
+#include "io_worker.h"
+
+// register behind each io_target, in the same order as the enum
+static const regmap::reg* const target_regs[IO_TARGET_COUNT] = {
+	&regmap::r_display,
+	&regmap::l_display,
+	&regmap::red_leds,
+	&regmap::green_leds
+};
+
+io_worker::io_worker(int fd, unsigned int period_us)
+	: m_fd(fd), m_period_us(period_us)
+{
+	memset(m_pending, 0, sizeof(m_pending));
+	memset(m_written, 0, sizeof(m_written));
+	memset(m_dirty, 0, sizeof(m_dirty));
+	memset(m_valid, 0, sizeof(m_valid));
+}
+
+io_worker::~io_worker()
+{
+	stop();
+}
+
+bool io_worker::start()
+{
+	io_input input;
+
+	if (m_running.load())
+		return true;
+
+	// callers usually check a switch right after opening, so the first
+	// sample must already be there when start() returns
+	if (!read_inputs(input))
+		return false;
+	m_inputs.store(input);
+
+	m_running.store(true);
+	try {
+		m_thread = std::thread(&io_worker::run, this);
+	} catch (const std::system_error&) {
+		// must not escape through the C interface (ihs_io_open)
+		m_running.store(false);
+		return false;
+	}
+	return true;
+}
+
+void io_worker::stop()
+{
+	if (!m_running.exchange(false))
+		return;
+	m_thread.join();
+	// whatever was posted before stop() still reaches the board
+	flush_outputs();
+}
+
+bool io_worker::poll(io_input& input)
+{
+	return m_inputs.load(input);
+}
+
+bool io_worker::post(const io_output& output)
+{
+	if (output.target >= IO_TARGET_COUNT)
+		return false;
+	return m_outputs.push(output);
+}
+
+void io_worker::run()
+{
+	auto period = std::chrono::microseconds(m_period_us);
+	auto next = std::chrono::steady_clock::now();
+	io_input input;
+
+	while (m_running.load(std::memory_order_relaxed)) {
+		flush_outputs();
+		if (read_inputs(input))
+			m_inputs.store(input);
+
+		next += period;
+		auto now = std::chrono::steady_clock::now();
+		if (next < now)
+			next = now; // a slow ioctl must not turn into a burst of polls
+		std::this_thread::sleep_until(next);
+	}
+}
+
+/* only the switches: the buttons reach the game as evdev key events, polling
+ * them here too would cost a second ioctl and read every period */
+bool io_worker::read_inputs(io_input& input)
+{
+	input.buttons = IO_BUTTONS_IDLE;
+	return regmap::read<regmap::switches>(m_fd, input.switches);
+}
+
+void io_worker::flush_outputs()
+{
+	io_output output;
+
+	// coalesce: only the last write posted to each target matters
+	while (m_outputs.pop(output)) {
+		m_pending[output.target] = output;
+		m_dirty[output.target] = true;
+	}
+
+	for (int i = 0; i < IO_TARGET_COUNT; i++) {
+		if (!m_dirty[i])
+			continue;
+
+		io_output& out = m_pending[i];
+		if (m_valid[i] && out.mode == m_written[i].mode && out.value == m_written[i].value) {
+			m_dirty[i] = false;
+			continue;
+		}
+
+		// on failure the target stays dirty and is retried on the next period,
+		// the game only posts a value once
+		if (ioctl(m_fd, target_regs[i]->cmd) < 0)
+			continue;
+		if (i <= IO_DISPLAY_L && (!m_valid[i] || out.mode != m_written[i].mode)) {
+			if (ioctl(m_fd, WR_DISPLAY_MODE, (unsigned long)out.mode) < 0)
+				continue;
+		}
+		uint32_t value = out.value & target_regs[i]->mask();
+		if (write(m_fd, &value, sizeof(value)) != sizeof(value))
+			continue;
+
+		m_written[i] = out;
+		m_valid[i] = true;
+		m_dirty[i] = false;
+	}
+}
+
+void* ihs_io_open(const char* path, unsigned int period_us)
+{
+	int fd;
+
+	if ((fd = open(path, O_RDWR)) < 0) {
+		fprintf(stderr, "Error opening file %s\n", path);
+		return NULL;
+	}
+
+	io_worker* worker = new (std::nothrow) io_worker(fd, period_us);
+	if (worker == NULL || !worker->start()) {
+		fprintf(stderr, "Error starting the io worker on %s\n", path);
+		delete worker;
+		close(fd);
+		return NULL;
+	}
+	return worker;
+}
+
+void ihs_io_close(void* handle)
+{
+	io_worker* worker = static_cast<io_worker*>(handle);
+	int fd;
+
+	if (worker == NULL)
+		return;
+	worker->stop();
+	fd = worker->fd();
+	delete worker;
+	close(fd);
+}
+
+int ihs_io_poll(void* handle, uint32_t* switches, uint32_t* buttons)
+{
+	io_input input;
+	int fresh = static_cast<io_worker*>(handle)->poll(input);
+
+	*switches = input.switches;
+	*buttons = input.buttons;
+	return fresh;
+}
+
+int ihs_io_post(void* handle, uint32_t target, uint32_t mode, uint32_t value)
+{
+	io_output output = { target, mode, value };
+	return static_cast<io_worker*>(handle)->post(output) ? 0 : -1;
+}
@@ -0,0 +1,240 @@
+#include <stdio.h>	/* printf, fopen... */
+#include <stdlib.h>	/* setenv */
+#include <string.h>	/* memcpy, strlen... */
+#include <strings.h>	/* strcasecmp */
+#include <stdint.h>	/* uints types */
+#include <errno.h>	/* error codes */
+#include <algorithm>	/* std::sort */
+#include <vector>	/* std::vector */
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+
+// bundle layout shared with the game loader
+#include "asset_bundle.h"
+
+/*
+ * Decodes every sprite and sound of the game once, at build time, and writes
+ * them to a single bundle: sprites as raw RGBA pixels packed in one atlas,
+ * sound effects as PCM already in the mixer format. The game maps the bundle and
+ * never opens or decodes the original files.
+ *
+ * usage: asset_packer <bundle> <asset>...
+ * asset paths are stored as given, so run it from the game folder.
+ */
+
+// same format pygame.mixer uses by default
+#define PACK_AUDIO_FREQ     44100
+#define PACK_AUDIO_FORMAT   AUDIO_S16LSB
+#define PACK_AUDIO_CHANNELS 2
+#define PACK_ATLAS_WIDTH    2048
+
+struct packed_image {
+	const char* name;
+	SDL_Surface* surface;
+	uint32_t x, y;
+};
+
+struct packed_sound {
+	const char* name;
+	Mix_Chunk* chunk;
+	uint64_t offset;
+};
+
+static uint64_t align_up(uint64_t value, uint64_t align)
+{
+	return (value + align - 1) & ~(align - 1);
+}
+
+static bool has_suffix(const char* str, const char* suffix)
+{
+	size_t len = strlen(str), slen = strlen(suffix);
+	return len >= slen && strcasecmp(str + len - slen, suffix) == 0;
+}
+
+// shelf packing: tallest images first, left to right, new shelf when a row is full
+static uint32_t pack_atlas(std::vector<packed_image>& images, uint32_t width)
+{
+	uint32_t x = 0, y = 0, shelf = 0;
+
+	std::sort(images.begin(), images.end(), [](const packed_image& a, const packed_image& b) {
+		return a.surface->h > b.surface->h;
+	});
+
+	for (auto& img : images) {
+		if (x + img.surface->w > width) {
+			x = 0;
+			y += shelf;
+			shelf = 0;
+		}
+		img.x = x;
+		img.y = y;
+		x += img.surface->w;
+		shelf = std::max(shelf, (uint32_t)img.surface->h);
+	}
+	return y + shelf;
+}
+
+static bool write_at(FILE* fp, uint64_t offset, const void* data, size_t len)
+{
+	return fseek(fp, (long)offset, SEEK_SET) == 0 && fwrite(data, 1, len, fp) == len;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<packed_image> images;
+	std::vector<packed_sound> sounds;
+	uint32_t atlas_width = PACK_ATLAS_WIDTH, atlas_height;
+	int audio_freq, audio_channels;
+	Uint16 audio_format;
+	int retval = 0;
+
+	if (argc < 3) {
+		printf("Syntax: %s <bundle file> <asset>...\n", argv[0]);
+		return -EINVAL;
+	}
+
+	// nothing is played, the mixer is only used to decode and convert
+	setenv("SDL_AUDIODRIVER", "dummy", 1);
+	if (SDL_Init(SDL_INIT_AUDIO) < 0 ||
+	    IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG) == 0 ||
+	    Mix_OpenAudio(PACK_AUDIO_FREQ, PACK_AUDIO_FORMAT, PACK_AUDIO_CHANNELS, 1024) < 0) {
+		fprintf(stderr, "Error initializing SDL: %s\n", SDL_GetError());
+		return -EIO;
+	}
+	// SDL may open a different spec than requested, the PCM is in the opened one
+	if (Mix_QuerySpec(&audio_freq, &audio_format, &audio_channels) == 0) {
+		fprintf(stderr, "Error querying the mixer format: %s\n", Mix_GetError());
+		retval = -EIO;
+		goto out;
+	}
+	Mix_Init(MIX_INIT_MP3);
+
+	for (int i = 2; i < argc; i++) {
+		const char* name = argv[i];
+
+		if (strlen(name) >= ASSET_NAME_LEN) {
+			fprintf(stderr, "Error: asset name too long %s\n", name);
+			retval = -ENAMETOOLONG;
+			goto out;
+		}
+
+		if (has_suffix(name, ".wav") || has_suffix(name, ".mp3") || has_suffix(name, ".ogg")) {
+			Mix_Chunk* chunk = Mix_LoadWAV(name);
+			if (chunk == NULL) {
+				fprintf(stderr, "Error decoding %s: %s\n", name, Mix_GetError());
+				retval = -EIO;
+				goto out;
+			}
+			sounds.push_back({ name, chunk, 0 });
+			continue;
+		}
+
+		SDL_Surface* loaded = IMG_Load(name);
+		if (loaded == NULL) {
+			fprintf(stderr, "Error decoding %s: %s\n", name, IMG_GetError());
+			retval = -EIO;
+			goto out;
+		}
+		// RGBA32 is R, G, B, A in memory, what pygame.image.frombuffer expects for "RGBA"
+		SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+		SDL_FreeSurface(loaded);
+		if (surface == NULL) {
+			fprintf(stderr, "Error converting %s: %s\n", name, SDL_GetError());
+			retval = -EIO;
+			goto out;
+		}
+		atlas_width = std::max(atlas_width, (uint32_t)surface->w);
+		images.push_back({ name, surface, 0, 0 });
+	}
+
+	atlas_height = pack_atlas(images, atlas_width);
+
+	{
+		asset_bundle_header header;
+		std::vector<asset_bundle_entry> entries;
+		std::vector<uint32_t> atlas((size_t)atlas_width * atlas_height, 0);
+		uint64_t offset;
+		FILE* fp;
+
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, ASSET_BUNDLE_MAGIC, sizeof(header.magic));
+		header.version = ASSET_BUNDLE_VERSION;
+		header.entry_count = images.size() + sounds.size();
+		header.atlas_width = atlas_width;
+		header.atlas_height = atlas_height;
+		header.audio_freq = audio_freq;
+		header.audio_format = audio_format;
+		header.audio_channels = audio_channels;
+
+		// the atlas gets its own pages, the sounds follow it
+		offset = sizeof(header) + header.entry_count * sizeof(asset_bundle_entry);
+		header.atlas_offset = align_up(offset, ASSET_PAGE_ALIGN);
+		offset = header.atlas_offset + atlas.size() * sizeof(uint32_t);
+		for (auto& snd : sounds) {
+			snd.offset = align_up(offset, ASSET_DATA_ALIGN);
+			offset = snd.offset + snd.chunk->alen;
+		}
+
+		for (auto& img : images) {
+			asset_bundle_entry entry;
+			memset(&entry, 0, sizeof(entry));
+			strncpy(entry.name, img.name, ASSET_NAME_LEN - 1);
+			entry.kind = ASSET_IMAGE;
+			entry.x = img.x;
+			entry.y = img.y;
+			entry.w = img.surface->w;
+			entry.h = img.surface->h;
+			entries.push_back(entry);
+
+			for (int row = 0; row < img.surface->h; row++)
+				memcpy(&atlas[(size_t)(img.y + row) * atlas_width + img.x],
+				       (const uint8_t*)img.surface->pixels + (size_t)row * img.surface->pitch,
+				       (size_t)img.surface->w * sizeof(uint32_t));
+		}
+
+		for (auto& snd : sounds) {
+			asset_bundle_entry entry;
+			memset(&entry, 0, sizeof(entry));
+			strncpy(entry.name, snd.name, ASSET_NAME_LEN - 1);
+			entry.kind = ASSET_SOUND;
+			entry.offset = snd.offset;
+			entry.size = snd.chunk->alen;
+			entries.push_back(entry);
+		}
+
+		if ((fp = fopen(argv[1], "wb")) == NULL) {
+			fprintf(stderr, "Error opening file %s\n", argv[1]);
+			retval = -EBUSY;
+			goto out;
+		}
+
+		bool ok = write_at(fp, 0, &header, sizeof(header)) &&
+			  write_at(fp, sizeof(header), entries.data(), entries.size() * sizeof(asset_bundle_entry)) &&
+			  write_at(fp, header.atlas_offset, atlas.data(), atlas.size() * sizeof(uint32_t));
+		for (auto& snd : sounds)
+			ok = ok && write_at(fp, snd.offset, snd.chunk->abuf, snd.chunk->alen);
+
+		if (fclose(fp) != 0 || !ok) {
+			fprintf(stderr, "Error writing file %s\n", argv[1]);
+			retval = -EIO;
+			goto out;
+		}
+
+		printf("packed %zu images (%ux%u atlas) and %zu sounds into %s (%llu Kbytes)\n",
+		       images.size(), atlas_width, atlas_height, sounds.size(), argv[1],
+		       (unsigned long long)(offset / 1024));
+	}
+
+out:
+	for (auto& img : images)
+		SDL_FreeSurface(img.surface);
+	for (auto& snd : sounds)
+		Mix_FreeChunk(snd.chunk);
+	Mix_CloseAudio();
+	Mix_Quit();
+	IMG_Quit();
+	SDL_Quit();
+	return retval;
+}
@@ -0,0 +1,56 @@
+#include <stdio.h>	/* printf, fopen... */
+#include <errno.h>	/* error codes */
+
+// register map and ioctl commands defined for the pci driver
+#include "regmap.hpp"
+
+/*
+ * Writes the python version of include/regmap.h, so the game uses the same
+ * ioctl numbers and widths as the driver instead of hard-coded decimals.
+ *
+ * usage: gen_regmap <output.py>
+ */
+
+int main(int argc, char** argv)
+{
+	FILE* fp;
+
+	if (argc < 2) {
+		printf("Syntax: %s <output file>\n", argv[0]);
+		return -EINVAL;
+	}
+
+	if ((fp = fopen(argv[1], "w")) == NULL) {
+		fprintf(stderr, "Error opening file %s\n", argv[1]);
+		return -EBUSY;
+	}
+
+	fprintf(fp, "# generated by ihs-project-layout-main/tools/gen_regmap.cpp from include/regmap.h\n");
+	fprintf(fp, "# (make regmap), do not edit\n\n");
+
+	fprintf(fp, "# ioctl commands\n");
+#define REGMAP_PY_CMD(cmd, id, nr, off, bits, rw, label) \
+	fprintf(fp, "%-15s = %lu\n", #cmd, (unsigned long)cmd);
+	REGMAP(REGMAP_PY_CMD)
+#undef REGMAP_PY_CMD
+	fprintf(fp, "%-15s = %lu\n", "WR_DISPLAY_MODE", (unsigned long)WR_DISPLAY_MODE);
+
+	fprintf(fp, "\n# valid bits of each register\n");
+#define REGMAP_PY_WIDTH(cmd, id, nr, off, bits, rw, label) \
+	fprintf(fp, "%-21s = %u\n", #cmd "_WIDTH", regmap::id.width);
+	REGMAP(REGMAP_PY_WIDTH)
+#undef REGMAP_PY_WIDTH
+
+	fprintf(fp, "\n# WR_DISPLAY_MODE arguments\n");
+	fprintf(fp, "DISPLAY_MODE_RAW  = %d\n", DISPLAY_MODE_RAW);
+	fprintf(fp, "DISPLAY_MODE_DEC  = %d\n", DISPLAY_MODE_DEC);
+	fprintf(fp, "DISPLAY_MODE_HEX  = %d\n", DISPLAY_MODE_HEX);
+	fprintf(fp, "DISPLAY_MODE_TEXT = %d\n", DISPLAY_MODE_TEXT);
+	fprintf(fp, "DISPLAY_NO_ZEROS  = %d\n", DISPLAY_NO_ZEROS);
+
+	if (fclose(fp) != 0) {
+		fprintf(stderr, "Error writing file %s\n", argv[1]);
+		return -EIO;
+	}
+	return 0;
+}
@@ -1,7 +1,10 @@
 import os, sys
+import ctypes
 
 from fcntl import ioctl
 
+from regmap import *
+
 HEX_0 = 0xC0
 HEX_1 = 0xF9
 HEX_2 = 0xA4
@@ -19,21 +22,52 @@ HEX_D = 0xA1
 HEX_E = 0x86
 HEX_F = 0x8E
 
-PB    = 24930
-SW    = 24929
-DIS_L = 24931
-DIS_R = 24932
-LED_R = 24933
-LED_G = 24934
+# comandos ioctl gerados do mapa de registradores do driver (regmap.py)
+PB    = RD_PBUTTONS
+SW    = RD_SWITCHES
+DIS_L = WR_L_DISPLAY
+DIS_R = WR_R_DISPLAY
+LED_R = WR_RED_LEDS
+LED_G = WR_GREEN_LEDS
+DIS_MODE = WR_DISPLAY_MODE
+
+# modos de escrita dos displays (argumento de DIS_MODE)
+DIS_RAW  = DISPLAY_MODE_RAW
+DIS_DEC  = DISPLAY_MODE_DEC
+DIS_HEX  = DISPLAY_MODE_HEX
+DIS_TEXT = DISPLAY_MODE_TEXT
+DIS_NO_ZEROS = DISPLAY_NO_ZEROS
+
+# biblioteca nativa com a thread de IO (make em ihs-project-layout-main)
+IHS_LIB = os.environ.get('IHS_LIB', os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                         '../ProjetoIHS/ihs-project-layout-main/target/release/libihs.so'))
+IO_PERIOD_US = 5000
+
+# saidas da thread de IO (enum io_target em io_worker.h)
+IO_DIS_R = 0
+IO_DIS_L = 1
+IO_LED_R = 2
+IO_LED_G = 3
+
+HEX_DIGITS = {'0': HEX_0, '1': HEX_1, '2': HEX_2, '3': HEX_3,
+              '4': HEX_4, '5': HEX_5, '6': HEX_6, '7': HEX_7,
+              '8': HEX_8, '9': HEX_9, 'A': HEX_A, 'B': HEX_B,
+              'C': HEX_C, 'D': HEX_D, 'E': HEX_E, 'F': HEX_F}
 
 class IO:
 
     def __init__(self) -> None:
         self.fd = os.open('/dev/mydev', os.O_RDWR)
         self.dev = SW
+        self.dp_mode = [None, None]
 
     def __del__(self):
-        os.close(self.fd)
+        self.close()
+
+    def close(self):
+        if self.fd is not None:
+            os.close(self.fd)
+            self.fd = None
 
     def get_SW(self, pos):
         ioctl(self.fd, SW)
@@ -61,11 +95,31 @@ class IO:
             data = (1 << num) | data
         os.write(self.fd, data.to_bytes(4, 'little'))
 
-    def put_DP(self, pos, ar_num):
+    def __select_DP(self, pos, mode):
         if pos == 0:
             ioctl(self.fd, DIS_R)
         else:
             ioctl(self.fd, DIS_L)
+        # o modo fica guardado no driver, so precisa ser enviado quando muda
+        if self.dp_mode[pos] != mode:
+            ioctl(self.fd, DIS_MODE, mode)
+            self.dp_mode[pos] = mode
+
+    def put_DP_num(self, pos, val, hexa=False, zeros=True):
+        # o driver converte o inteiro para os segmentos
+        mode = DIS_HEX if hexa else DIS_DEC
+        if not zeros:
+            mode = mode | DIS_NO_ZEROS
+        self.__select_DP(pos, mode)
+        os.write(self.fd, val.to_bytes(4, 'little'))
+
+    def put_DP_text(self, pos, text):
+        # ate 4 caracteres ASCII, alinhados a esquerda
+        self.__select_DP(pos, DIS_TEXT)
+        os.write(self.fd, text[:4].encode('ascii'))
+
+    def put_DP(self, pos, ar_num):
+        self.__select_DP(pos, DIS_RAW)
 
         data = 0
         for num in ar_num:
@@ -106,4 +160,91 @@ class IO:
             data = data | HEX_E
         elif num == 'F':
             data = data | HEX_F
-        return data
\ No newline at end of file
+        return data
+
+
+class AsyncIO:
+    """Mesma interface de IO, mas o acesso a placa fica numa thread nativa.
+
+    As leituras devolvem a ultima amostra feita pela thread e as escritas
+    sao apenas enfileiradas, nenhuma chamada bloqueia o loop do jogo.
+    """
+
+    def __init__(self, path='/dev/mydev', period_us=IO_PERIOD_US) -> None:
+        self.lib = ctypes.CDLL(IHS_LIB)
+        self.lib.ihs_io_open.restype = ctypes.c_void_p
+        self.lib.ihs_io_open.argtypes = [ctypes.c_char_p, ctypes.c_uint]
+        self.lib.ihs_io_close.argtypes = [ctypes.c_void_p]
+        self.lib.ihs_io_poll.argtypes = [ctypes.c_void_p,
+                                         ctypes.POINTER(ctypes.c_uint32),
+                                         ctypes.POINTER(ctypes.c_uint32)]
+        self.lib.ihs_io_post.argtypes = [ctypes.c_void_p, ctypes.c_uint32,
+                                         ctypes.c_uint32, ctypes.c_uint32]
+        self.handle = self.lib.ihs_io_open(path.encode(), period_us)
+        if not self.handle:
+            raise OSError("could not start the io worker on %s" % path)
+        self.sw = ctypes.c_uint32()
+        self.pb = ctypes.c_uint32()
+        # a thread ja junta escritas repetidas, aqui so evita encher a fila
+        self.last = {}
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        # para a thread depois de enviar as escritas pendentes
+        if getattr(self, 'handle', None):
+            self.lib.ihs_io_close(self.handle)
+            self.handle = None
+
+    def __poll(self):
+        self.lib.ihs_io_poll(self.handle, ctypes.byref(self.sw), ctypes.byref(self.pb))
+
+    def __post(self, target, mode, val):
+        if self.last.get(target) == (mode, val):
+            return
+        if self.lib.ihs_io_post(self.handle, target, mode, val) == 0:
+            self.last[target] = (mode, val)
+
+    def get_SW(self, pos):
+        self.__poll()
+        return 1 if (self.sw.value & (1 << pos)) > 0 else 0
+
+    def get_PB(self, pos):
+        # a thread nao le os botoes (chegam como eventos do evdev), sempre soltos
+        self.__poll()
+        return 1 if (self.pb.value & (1 << pos)) > 0 else 0
+
+    def put_LD(self, val):
+        self.__post(IO_LED_R, DIS_RAW, val)
+
+    def put_ar_LD(self, list_pos):
+        data = 0
+        for num in list_pos:
+            data = (1 << num) | data
+        self.__post(IO_LED_R, DIS_RAW, data)
+
+    def put_DP_num(self, pos, val, hexa=False, zeros=True):
+        mode = DIS_HEX if hexa else DIS_DEC
+        if not zeros:
+            mode = mode | DIS_NO_ZEROS
+        self.__post(IO_DIS_R if pos == 0 else IO_DIS_L, mode, val)
+
+    def put_DP_text(self, pos, text):
+        # o driver le os caracteres na ordem dos bytes escritos
+        data = int.from_bytes(text[:4].ljust(4).encode('ascii'), 'little')
+        self.__post(IO_DIS_R if pos == 0 else IO_DIS_L, DIS_TEXT, data)
+
+    def put_DP(self, pos, ar_num):
+        data = 0
+        for num in ar_num:
+            data = (data << 8) | HEX_DIGITS.get(num, 0)
+        self.__post(IO_DIS_R if pos == 0 else IO_DIS_L, DIS_RAW, data)
+
+
+def create_IO():
+    # usa a thread nativa quando a biblioteca foi compilada
+    try:
+        return AsyncIO()
+    except OSError:
+        return IO()
@@ -0,0 +1,26 @@
+# generated by ihs-project-layout-main/tools/gen_regmap.cpp from include/regmap.h
+# (make regmap), do not edit
+
+# ioctl commands
+RD_SWITCHES     = 24929
+RD_PBUTTONS     = 24930
+WR_L_DISPLAY    = 24931
+WR_R_DISPLAY    = 24932
+WR_RED_LEDS     = 24933
+WR_GREEN_LEDS   = 24934
+WR_DISPLAY_MODE = 24960
+
+# valid bits of each register
+RD_SWITCHES_WIDTH     = 18
+RD_PBUTTONS_WIDTH     = 4
+WR_L_DISPLAY_WIDTH    = 32
+WR_R_DISPLAY_WIDTH    = 32
+WR_RED_LEDS_WIDTH     = 18
+WR_GREEN_LEDS_WIDTH   = 9
+
+# WR_DISPLAY_MODE arguments
+DISPLAY_MODE_RAW  = 0
+DISPLAY_MODE_DEC  = 1
+DISPLAY_MODE_HEX  = 2
+DISPLAY_MODE_TEXT = 3
+DISPLAY_NO_ZEROS  = 16
@@ -0,0 +1,114 @@
+"""
+This module loads images and sounds for the game.
+Assets come from the bundle written by the asset packer
+(make assets in ihs-project-layout-main): every sprite already decoded
+in a single RGBA atlas and every sound as PCM, read through mmap.
+When the bundle is missing (or an asset is not in it) the original file is
+loaded instead. Layout of the bundle: include/asset_bundle.h
+"""
+import mmap
+import struct
+
+import pygame
+from pygame import image, transform
+
+from src.log_handle import get_logger
+logger = get_logger(__name__)
+
+BUNDLE_PATH = "assets/assets.pak"
+BUNDLE_MAGIC = b"IHSPAK\x00\x00"
+BUNDLE_VERSION = 1
+HEADER = struct.Struct("<8sIIIIQIHHII")
+ENTRY = struct.Struct("<64sIIIIIIQQ")
+ASSET_IMAGE = 1
+ASSET_SOUND = 2
+AUDIO_S16LSB = 0x8010
+
+
+class AssetBundle:
+    def __init__(self, path=BUNDLE_PATH):
+        self._images = {}
+        self._sounds = {}
+        self._atlas = None
+        with open(path, "rb") as fp:
+            self._map = mmap.mmap(fp.fileno(), 0, access=mmap.ACCESS_READ)
+        self._view = memoryview(self._map)
+        (magic, version, count, self._atlas_w, self._atlas_h, self._atlas_offset,
+         freq, fmt, channels, _, _) = HEADER.unpack_from(self._map, 0)
+        if magic != BUNDLE_MAGIC or version != BUNDLE_VERSION:
+            raise ValueError(f"{path} is not a version {BUNDLE_VERSION} asset bundle")
+        self._audio = (freq, -16 if fmt == AUDIO_S16LSB else None, channels)
+        for idx in range(count):
+            name, kind, x, y, w, h, _, offset, size = \
+                ENTRY.unpack_from(self._map, HEADER.size + idx * ENTRY.size)
+            name = name.rstrip(b"\x00").decode()
+            if kind == ASSET_IMAGE:
+                self._images[name] = (x, y, w, h)
+            elif kind == ASSET_SOUND:
+                self._sounds[name] = (offset, size)
+
+    def _get_atlas(self):
+        if self._atlas is None:
+            end = self._atlas_offset + self._atlas_w * self._atlas_h * 4
+            atlas = image.frombuffer(self._view[self._atlas_offset:end],
+                                     (self._atlas_w, self._atlas_h), "RGBA")
+            # one conversion for the whole atlas instead of one per sprite
+            self._atlas = atlas.convert_alpha() if pygame.display.get_surface() else atlas
+        return self._atlas
+
+    def get_image(self, path):
+        rect = self._images.get(path)
+        if rect is None:
+            return None
+        return self._get_atlas().subsurface(rect)
+
+    def get_sound(self, path):
+        data = self._sounds.get(path)
+        # the PCM can only be used as is if the mixer runs in the packed format
+        if data is None or pygame.mixer.get_init() != self._audio:
+            return None
+        offset, size = data
+        return pygame.mixer.Sound(buffer=self._view[offset:offset + size])
+
+
+_bundle = None
+_bundle_checked = False
+_image_cache = {}
+
+
+def get_bundle():
+    global _bundle, _bundle_checked
+    if not _bundle_checked:
+        _bundle_checked = True
+        try:
+            _bundle = AssetBundle()
+            logger.info("asset bundle %s loaded", BUNDLE_PATH)
+        except (OSError, ValueError) as err:
+            logger.info("asset bundle not used: %s", err)
+    return _bundle
+
+
+def load_image(path, size=None):
+    """Image ready to blit, optionally scaled. Results are cached, so
+    level resets reuse them; callers must not draw on the returned surface."""
+    key = (path, size)
+    if key in _image_cache:
+        return _image_cache[key]
+    bundle = get_bundle()
+    surface = bundle.get_image(path) if bundle else None
+    if surface is None:
+        surface = image.load(path)
+        if pygame.display.get_surface():
+            surface = surface.convert_alpha()
+    if size is not None:
+        surface = transform.scale(surface, size)
+    _image_cache[key] = surface
+    return surface
+
+
+def load_sound(path):
+    bundle = get_bundle()
+    sound = bundle.get_sound(path) if bundle else None
+    if sound is None:
+        sound = pygame.mixer.Sound(path)
+    return sound
@@ -2,7 +2,6 @@ from pygame import (K_DOWN, K_ESCAPE, K_LEFT, K_RIGHT, K_SPACE, K_UP, KEYDOWN,
                     QUIT, K_q)
 from pygame import USEREVENT
 from pygame.time import set_timer
-from integracao import *
 
 class EventHandler:
     def __init__(self, screen, game_state):
@@ -12,15 +11,16 @@ class EventHandler:
     def pygame_quit(self):
         self._game_screen.running = False
 
-    def key_bindings(self):
-        Integration=IO()
-        if Integration.get_PB(3)==0:
+    # Os botoes da placa chegam como setas pelo dispositivo de entrada do driver
+    # (PB3 esquerda, PB0 direita, PB2 cima, PB1 baixo), igual ao teclado
+    def key_bindings(self, key):
+        if key == K_LEFT:
             self._game_screen.direction = "l"
-        elif Integration.get_PB(0)==0:
+        elif key == K_RIGHT:
             self._game_screen.direction = "r"
-        elif Integration.get_PB(2)==0:
+        elif key == K_UP:
             self._game_screen.direction = "u"
-        elif Integration.get_PB(1)==0:
+        elif key == K_DOWN:
             self._game_screen.direction = "d"
 
     def handle_events(self, event):
@@ -28,7 +28,7 @@ class EventHandler:
             self.pygame_quit()
 
         if event.type == KEYDOWN:
-            self.key_bindings()
+            self.key_bindings(event.key)
         
         if event.type == self._game_screen.custom_event:
             curr_mode = self._game_screen.ghost_mode
@@ -1,11 +1,10 @@
 from src.configs import loading_screen_gif
-from pygame import image, transform
+from src.assets import load_image
 
 class LoadingScreen:
     def __init__(self, screen):
         self.screen = screen
-        self.loading_image = image.load(loading_screen_gif)  # Load the image
-        self.loading_image = transform.scale(self.loading_image, (192, 192))
+        self.loading_image = load_image(loading_screen_gif, (192, 192))  # Load the image
 
     def draw_loading(self):
         self.screen.blit(self.loading_image, (500, 500))
\ No newline at end of file
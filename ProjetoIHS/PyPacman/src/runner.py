@@ -26,33 +26,27 @@ class GameRun:
         logger.info("pygame initialized")
         self.game_state = GameState()
         logger.info("game state object created")
+        # IO setup: a thread nativa faz o acesso a placa fora do loop de render
+        self.io = create_IO()
         self.events = EventHandler(self.screen, self.game_state)
         logger.info("event handler object created")
         self.all_sprites = pygame.sprite.Group()
         self.gui = ScreenManager(self.screen, self.game_state, self.all_sprites)
         logger.info("screen manager object created")
-         
-        # IO setup
-        self.io = IO()
         
     # Modificacao    
     def update_display(self):
         # Atualiza o display de 7 segmentos com a pontuação e o highscore
-        score_str = str(self.game_state.points).zfill(4)  # Certifica-se de que a pontuação tenha 4 dígitos
-        highscore_str = str(self.game_state.highscore).zfill(4)  # Certifica-se de que o highscore tenha 4 dígitos
-
-        self.io.put_DP(0, score_str)  # Atualiza o display direito com a pontuação
-        self.io.put_DP(1, highscore_str)  # Atualiza o display esquerdo com o highscore
+        # O driver faz a conversão para decimal com 4 dígitos
+        self.io.put_DP_num(0, self.game_state.points)  # Atualiza o display direito com a pontuação
+        self.io.put_DP_num(1, self.game_state.highscore)  # Atualiza o display esquerdo com o highscore
         
     # Modificacao    
     def finish_display(self):
         # Atualiza o display de 7 segmentos com a pontuação e o highscore
-        score_str = "0000"
-        highscore_str = "0000"
-        
         time.sleep(0.5)  # Pequeno atraso para garantir atualização
-        self.io.put_DP(0, score_str)  # Atualiza o display direito com a pontuação
-        self.io.put_DP(1, highscore_str)  # Atualiza o display esquerdo com o highscore
+        self.io.put_DP_num(0, 0)  # Atualiza o display direito com a pontuação
+        self.io.put_DP_num(1, 0)  # Atualiza o display esquerdo com o highscore
         
     def update_led_score(self):
         # Calcular o número de LEDs a serem acesos com base na pontuação
@@ -61,7 +55,7 @@ class GameRun:
         # Atualizar o estado dos LEDs
         for i in range(num_leds_to_light):
             array.append(i)
-            self.io.put_ar_LD(array)  # Substitua por sua função específica para acender LEDs
+        self.io.put_ar_LD(array)  # Uma única escrita por atualização
     
     # Funcao de inicializacao dos leds
     def iniciar_leds(self):
@@ -131,6 +125,7 @@ class GameRun:
             self.gui.draw_screens()
             self.all_sprites.draw(self.screen)
             self.all_sprites.update(dt)
+            self.gui.pacman.ghost.plan_movements()  # Decisoes dos fantasmas em lote
             self.check_highscores()
             pygame.display.flip()
             dt = clock.tick(self.game_state.fps)
@@ -139,6 +134,7 @@ class GameRun:
         self.update_highscore()
         self.iniciar_leds()  # Modificação: Reseta os LEDs ao sair do jogo
         self.finish_display()
+        self.io.close()
 
         pygame.quit()
         sys.exit()
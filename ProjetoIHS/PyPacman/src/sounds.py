@@ -1,5 +1,7 @@
 import pygame
 
+from src.assets import load_sound
+
 
 class SoundManager:
     _instance = None
@@ -24,7 +26,7 @@ class SoundManager:
                    freq=200,
                    channel=0):
         """Loads a sound effect and assigns it a name."""
-        self._sounds[name] = {"sound": pygame.mixer.Sound(filepath),
+        self._sounds[name] = {"sound": load_sound(filepath),
                               "freq": freq,
                               'last_played': 0}
         self._sounds[name]['sound'].set_volume(volumne)
@@ -4,6 +4,7 @@ A single ghost class responsible for rending ghost,
 ghost manager class responsible for creating multiple ghost objects aka ghosts
 ghose movement class responsible for moving the ghost with lerp
 GhostManager takes ghost matrix pos, grid start pos, matrix, game state object.
+GhostManager also solves the moves the ghosts ask for in a frame in one batch (plan_movements).
 Ghost takes name, ghost matrix pos, grid start pos, matrix and game state object
 Ghost movement class should need ghost coordinate pos, matrix, game state, some more parameters.
 """
@@ -11,7 +12,6 @@ from abc import abstractmethod, ABC
 
 from pygame.sprite import Sprite
 from pygame import Surface
-from pygame import image, transform
 import pygame.time as pytime
 from pygame.time import wait
 from pygame.rect import Rect
@@ -23,7 +23,9 @@ from src.sprites.sprite_configs import GHOST_PATHS
 from src.configs import PACMAN, CELL_SIZE, GHOST_DELAYS, GHOST_SCATTER_TARGETS, GHOST_POINT
 from src.utils.coord_utils import get_coords_from_idx, get_idx_from_coords
 from src.utils.ghost_movement_utils import get_direction, get_is_intersection, get_is_move_valid
+from src.utils.ghost_planner import create_planner
 from src.sounds import SoundManager
+from src.assets import load_image
 
 from src.log_handle import get_logger
 logger = get_logger(__name__)
@@ -34,7 +36,8 @@ class Ghost(Sprite, ABC):
                  ghost_matrix_pos: tuple[int, int],
                  grid_start_pos: tuple[int | float, int | float],
                  matrix: list[list[str]],
-                 game_state: GameState
+                 game_state: GameState,
+                 planner=None
                  ):
         super().__init__()
         self.name = name
@@ -61,6 +64,8 @@ class Ghost(Sprite, ABC):
         self.is_scared = False
         self.curr_pos = None
         self.release_time = None
+        self._planner = planner
+        self._pending = None
         self.sounds = SoundManager()
         self.load_images()
 
@@ -79,10 +84,8 @@ class Ghost(Sprite, ABC):
     def load_images(self):
         ghost_images = GHOST_PATHS[self.name][0]
         blue_images = GHOST_PATHS['blue'][0]
-        self.normal_image = transform.scale(image.load(ghost_images).convert_alpha(),
-                                     PACMAN)
-        self.blue_image = transform.scale(image.load(blue_images).convert_alpha(),
-                                     PACMAN)
+        self.normal_image = load_image(ghost_images, PACMAN)
+        self.blue_image = load_image(blue_images, PACMAN)
         self.image = self.normal_image
         x, y = self._get_coords_from_idx(self._ghost_matrix_pos)
         self.rect = self.image.get_rect(topleft=(x, y))
@@ -132,12 +135,12 @@ class Ghost(Sprite, ABC):
             if get_is_intersection(self.next_tile, self._matrix, 
                                    prev_val):
                 
-                self.prepare_movement()
+                self.request_movement()
             else:
                 if not get_is_move_valid(self.next_tile, 
                                          self._get_direction_reverse_map(self._direction), 
                                          self._matrix):
-                    self.prepare_movement()
+                    self.request_movement()
                 else:
                     self.prev = self.next_tile
                     self.next_tile = (self.next_tile[0] + self._direction[0],
@@ -166,6 +169,12 @@ class Ghost(Sprite, ABC):
             self.next_tile = (self.next_tile[0], self.num_cols - 1)
 
     def prepare_movement(self):
+        self.request_movement()
+        self.resolve_movement()
+
+    def request_movement(self):
+        """Queues the (tile, target, prev) decision, GhostManager.plan_movements solves it
+        with the other ghosts at the end of the frame. Without a planner it is solved now."""
         ghost_x, ghost_y = self._get_idx_from_coords((self.rect_x, self.rect_y))
         if self.next_tile:
             ghost_x, ghost_y = self.next_tile
@@ -174,11 +183,28 @@ class Ghost(Sprite, ABC):
         else:
             self._target = self.determine_target()
         prev = self._direction_prevent.get(self._direction)
-        self._direction = get_direction((ghost_x, ghost_y),
-                                        self._target, 
-                                        self._matrix, 
-                                        prev
-                                        )
+        self._pending = ((ghost_x, ghost_y), self._target, prev)
+        if self._planner is None:
+            self.resolve_movement()
+
+    def resolve_movement(self):
+        if self._pending is None:
+            return
+        if self._planner is None:
+            direction = get_direction(self._pending[0], self._pending[1],
+                                      self._matrix, self._pending[2])
+        else:
+            direction = self._planner.plan([self._pending])[0]
+        self.apply_movement(direction)
+
+    @property
+    def pending_movement(self):
+        return self._pending
+
+    def apply_movement(self, direction):
+        ghost_x, ghost_y = self._pending[0]
+        self._pending = None
+        self._direction = direction
         self._t = 0
         self.next_tile = (ghost_x + self._direction[0], 
                           ghost_y + self._direction[1])
@@ -216,6 +242,7 @@ class Ghost(Sprite, ABC):
         return rand_row, rand_col
     
     def make_ghost_scared(self):
+        self.resolve_movement()
         self._direction = self._direction_prevent[self._direction]
         self.is_scared = True
         self.prepare_movement()
@@ -241,6 +268,7 @@ class Ghost(Sprite, ABC):
         self._t = 0
         self._direction = None
         self._target = None
+        self._pending = None
         self._curr_pos = None
         self.prev = None
         self.next_tile = None
@@ -365,6 +393,8 @@ class GhostManager:
         self.ghost_matrix_pos = ghost_matrix_pos
         self.grid_start_pos = grid_start_pos
         self.ghosts_list = []
+        self.planner = create_planner()
+        self.planner.set_matrix(self.matrix)
         self.load_ghosts()
     
     def load_ghosts(self):
@@ -380,5 +410,15 @@ class GhostManager:
                                           ghost_pos,
                                           self.grid_start_pos,
                                           self.matrix,
-                                          self.game_state))
-            adder += 1
\ No newline at end of file
+                                          self.game_state,
+                                          self.planner))
+            adder += 1
+
+    def plan_movements(self):
+        """Solves in one call every move the ghosts asked for during this frame."""
+        waiting = [ghost for ghost in self.ghosts_list if ghost.pending_movement]
+        if not waiting:
+            return
+        directions = self.planner.plan([ghost.pending_movement for ghost in waiting])
+        for ghost, direction in zip(waiting, directions):
+            ghost.apply_movement(direction)
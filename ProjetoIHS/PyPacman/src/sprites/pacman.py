@@ -1,8 +1,5 @@
-from integracao import *
-
 from math import ceil
 
-from pygame import image, transform
 from pygame.sprite import Sprite
 from pygame import Surface, USEREVENT
 from pygame.time import set_timer, get_ticks
@@ -15,6 +12,7 @@ from src.utils.coord_utils import (get_coords_from_idx,
                                    get_tiny_matrix,
                                    precompute_matrix_coords)
 from src.sounds import SoundManager
+from src.assets import load_image
 from src.log_handle import get_logger
 logger = get_logger(__name__)
 
@@ -91,7 +89,7 @@ class Pacman(Sprite):
         def frame_helper(direction):
             width, height = PACMAN
             return [
-                transform.scale(image.load(path).convert_alpha(), (width, height))
+                load_image(path, (width, height))
                 for path in PACMAN_PATHS[direction]
             ]
         self.curr_frame_idx = 0
@@ -172,18 +170,6 @@ class Pacman(Sprite):
                 self.collectibles -= 1
                 self.game_state.points += POWER_POINT
                 
-    def read_inputs_from_board(self):
-        Integration = IO()
-        """Lê os botões da placa e ajusta a direção do Pacman."""
-        if Integration.get_PB(3) == 0:  # Botão pressionado
-            self.game_state.direction = 'l'  # Define para mover à esquerda
-        elif Integration.get_PB(0) == 0:
-            self.game_state.direction = 'r'
-        elif Integration.get_PB(2) == 0:
-            self.game_state.direction = 'u'
-        elif Integration.get_PB(1) == 0:
-            self.game_state.direction = 'd'
-                
     def movement_bind(self):
         match self.game_state.direction:
             case 'l':
@@ -239,7 +225,6 @@ class Pacman(Sprite):
                                        CELL_SIZE[0]*2, CELL_SIZE[0]*2)
 
     def update(self, dt: float):
-        self.read_inputs_from_board()  # Lê os botões da placa antes de mover
         self.frame_update()
         self.build_bounding_boxes(self.rect_x, self.rect_y)
         self.movement_bind()
@@ -0,0 +1,94 @@
+"""
+This module plans the ghost moves in batches.
+GhostManager collects the decisions every ghost needs in a frame and
+solves them with a single plan() call. NativePlanner runs them in
+libihs.so (lib/ghost_planner.cpp in ihs-project-layout-main), which caches
+each decision on (tile, target, prev) and solves the misses on a small
+thread pool. PythonPlanner is the fallback when the library is not built.
+Both give the same answer as get_direction.
+"""
+import ctypes
+
+from integracao import IHS_LIB
+from src.utils.ghost_movement_utils import BLOCKERS, get_direction
+
+# same order as enum ghost_dir in include/ghost_planner.h
+DIRECTIONS = [(-1, 0), (0, -1), (1, 0), (0, 1)]
+GHOST_NO_DIR = -1
+GHOST_FALLBACK = -2
+
+
+class GhostQuery(ctypes.Structure):
+    _fields_ = [("row", ctypes.c_int32),
+                ("col", ctypes.c_int32),
+                ("target_row", ctypes.c_int32),
+                ("target_col", ctypes.c_int32),
+                ("prev", ctypes.c_int32)]
+
+
+class PythonPlanner:
+    def set_matrix(self, matrix):
+        self.matrix = matrix
+
+    def plan(self, queries):
+        return [get_direction(pos, target, self.matrix, prev)
+                for pos, target, prev in queries]
+
+
+class NativePlanner:
+    def __init__(self, workers=0):
+        self.lib = ctypes.CDLL(IHS_LIB)
+        self.lib.ihs_planner_open.restype = ctypes.c_void_p
+        self.lib.ihs_planner_open.argtypes = [ctypes.c_uint]
+        self.lib.ihs_planner_close.argtypes = [ctypes.c_void_p]
+        self.lib.ihs_planner_set_matrix.argtypes = [ctypes.c_void_p, ctypes.c_int,
+                                                    ctypes.c_int, ctypes.c_char_p]
+        self.lib.ihs_planner_plan.argtypes = [ctypes.c_void_p, ctypes.POINTER(GhostQuery),
+                                              ctypes.c_int, ctypes.POINTER(ctypes.c_int8)]
+        self.handle = self.lib.ihs_planner_open(workers)
+        if not self.handle:
+            raise OSError("could not create the ghost planner")
+        self.matrix = None
+
+    def __del__(self):
+        if getattr(self, 'handle', None):
+            self.lib.ihs_planner_close(self.handle)
+            self.handle = None
+
+    def set_matrix(self, matrix):
+        # only the walls matter, eaten dots do not change any decision
+        blocked = bytes(cell in BLOCKERS for row in matrix for cell in row)
+        self.lib.ihs_planner_set_matrix(self.handle, len(matrix), len(matrix[0]), blocked)
+        self.matrix = matrix
+
+    def plan(self, queries):
+        count = len(queries)
+        batch = (GhostQuery * count)()
+        for query, (pos, target, prev) in zip(batch, queries):
+            query.row, query.col = pos
+            query.target_row, query.target_col = target
+            query.prev = DIRECTIONS.index(prev) if prev is not None else -1
+        out = (ctypes.c_int8 * count)()
+        self.lib.ihs_planner_plan(self.handle, batch, count, out)
+
+        directions = []
+        for (pos, target, prev), direction in zip(queries, out):
+            if direction < 0:
+                # dead ends and out of matrix tiles keep the python behaviour
+                directions.append(get_direction(pos, target, self.matrix, prev))
+            else:
+                directions.append(DIRECTIONS[direction])
+        return directions
+
+
+_planner = None
+
+def create_planner():
+    # one native planner (and thread pool) shared by every GhostManager
+    global _planner
+    if _planner is None:
+        try:
+            _planner = NativePlanner()
+        except (OSError, AttributeError):
+            _planner = False
+    return _planner or PythonPlanner()